@@ -8,6 +8,12 @@ std::complex<double> W(int N, int k);
 
 cv::Mat FFT(cv::Mat xn, int N, QString type);
 
+int nextPowerOfTwo(int n);
+
+cv::Mat expandToComplex(cv::Mat xnm, int N, QString type);
+
+void fftShift(cv::Mat& complexImg);
+
 cv::Mat FFT2D(cv::Mat xnm, QString type);
 
 #endif // FFT_HPP
\ No newline at end of file
@@ -6,6 +6,10 @@
 
 cv::Mat IFFT(cv::Mat Xk, int N);
 
+void fftInverseShift(cv::Mat& complexImg);
+
+cv::Mat cropFromComplex(cv::Mat xnm, int origin_rows, int origin_cols, QString type);
+
 cv::Mat IFFT2D(cv::Mat Xkv, int origin_rows, int origin_cols, QString type);
 
 cv::Mat createGaussianLPF(cv::Size size, float sigma);
@@ -0,0 +1,70 @@
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <QString>
+#include "planner.hpp"
+
+/**
+ * @brief 界面处理流程的数据流图：载入 -> 灰度图 -> 频谱 -> 滤波器(sigma) -> 重建 -> MSE/PSNR
+ *        每个节点的结果都会缓存，只在被读取且已失效时才计算；
+ *        修改输入时只让受影响的下游节点失效
+ */
+class ProcessingGraph
+{
+    public:
+        /**
+         * @brief 数据流图中的节点
+         */
+        enum Node
+        {
+            NODE_GRAY, // 灰度图
+            NODE_SPECTRUM, // 中心化的频域复数矩阵
+            NODE_SPECTRUM_IMAGE, // 按显示尺寸生成的对数幅度谱或相位谱
+            NODE_FILTER, // 高斯低通滤波器
+            NODE_RECOVERED, // 直接IFFT得到的重建图像
+            NODE_FILTERED_RECOVERED, // 滤波后IFFT得到的重建图像
+            NODE_METRICS, // 重建图像与原图的MSE和PSNR
+            NODE_FILTERED_METRICS, // 滤波重建图像与原图的MSE和PSNR
+            NODE_COUNT
+        };
+
+        ProcessingGraph();
+
+        void setFilePath(QString file_path);
+        void setSigma(int sigma);
+        void setDisplaySize(cv::Size display_size);
+        void setShowPhase(bool show_phase);
+
+        const cv::Mat& gray();
+        const cv::Mat& spectrum();
+        const cv::Mat& spectrumImage();
+        const cv::Mat& filter();
+        const cv::Mat& recovered(bool filtered);
+        double mse(bool filtered);
+        double psnr(bool filtered);
+
+    private:
+        QString file_path; // 输入图像路径
+        int sigma; // 高斯低通滤波器的sigma
+        cv::Size display_size; // 频谱图的显示尺寸
+        bool show_phase; // 频谱图显示相位谱还是对数幅度谱
+        bool valid[NODE_COUNT]; // 每个节点的缓存是否有效
+
+        FFTPlan plan; // 当前图像尺寸下的FFT/IFFT执行计划，随频谱一起更新
+        cv::Mat gray_image; // 灰度图
+        cv::Mat Xkv; // FFT后的结果
+        cv::Mat Xkv_8u; // 对数幅度谱或相位谱
+        cv::Mat lpf; // 高斯低通滤波器
+        cv::Mat xnm_recovered; // 直接重建的图像
+        cv::Mat xnm_filtered_recovered; // 滤波后重建的图像
+        double recoveredMSE; // 重建图像与原图的均方误差
+        double recoveredPSNR; // 重建图像与原图的峰值信噪比
+        double lpfMSE; // 低通滤波后的重建图像与原图的均方误差
+        double lpfPSNR; // 低通滤波后的重建图像与原图的峰值信噪比
+
+        void invalidate(Node node);
+        void computeMetrics(bool filtered);
+};
+
+#endif // PIPELINE_HPP
@@ -0,0 +1,41 @@
+#ifndef PLANNER_HPP
+#define PLANNER_HPP
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <QString>
+
+/**
+ * @brief 规划器的工作模式
+ *        ESTIMATE：不做任何测试，优先使用wisdom中已有的计划，否则按经验规则选择
+ *        MEASURE：wisdom中没有时，实际测量所有候选策略的耗时，选择最快的并记入wisdom
+ */
+enum PlannerMode
+{
+    PLANNER_ESTIMATE,
+    PLANNER_MEASURE
+};
+
+/**
+ * @brief 某一FFT点数下选定的二维FFT/IFFT执行计划
+ */
+struct FFTPlan
+{
+    int N; // FFT点数（2的整数次方）
+    QString strategy; // 执行策略，支持的有serial、threaded、slab
+    int workers; // threaded策略的线程数或slab策略的进程数，serial策略为1
+    double seconds; // MEASURE模式下测得的一次FFT2D加一次IFFT2D的耗时（秒），ESTIMATE模式下为0
+};
+
+FFTPlan planFFT2D(int N, PlannerMode mode, bool allow_processes = false);
+
+cv::Mat executeFFT2D(const FFTPlan& plan, cv::Mat xnm, QString type);
+
+cv::Mat executeIFFT2D(const FFTPlan& plan, cv::Mat Xkv, int origin_rows, int origin_cols, QString type);
+
+bool loadWisdom(QString path);
+
+bool saveWisdom(QString path);
+
+void forgetWisdom();
+
+#endif // PLANNER_HPP
@@ -0,0 +1,27 @@
+#ifndef SLAB_HPP
+#define SLAB_HPP
+#include <iostream>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <QString>
+
+/**
+ * @brief 多进程FFT2D在某一进程数下的扩展性测试结果
+ */
+struct SlabScaling
+{
+    int processes; // 工作进程数
+    double seconds; // 一次FFT2D的平均耗时（秒）
+    double speedup; // 相对于单进程的加速比
+    double efficiency; // 扩展效率，即加速比除以进程数
+    double max_error; // 与单进程FFT2D结果的最大误差
+    double roundtrip_error; // 用同样的进程数IFFT2D重建后与原图的最大误差
+};
+
+cv::Mat FFT2DSlab(cv::Mat xnm, QString type, int processes);
+
+cv::Mat IFFT2DSlab(cv::Mat Xkv, int origin_rows, int origin_cols, QString type, int processes);
+
+std::vector<SlabScaling> benchmarkSlabFFT2D(int N, int max_processes, int repeats);
+
+#endif // SLAB_HPP
@@ -0,0 +1,15 @@
+#ifndef SPECTRUM_HPP
+#define SPECTRUM_HPP
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <QString>
+
+cv::Size fitDisplaySize(cv::Size spectrum_size, cv::Size display_size);
+
+cv::Mat renderMagnitudeSpectrum(const cv::Mat& Xkv, cv::Size display_size);
+
+cv::Mat renderPhaseSpectrum(const cv::Mat& Xkv, cv::Size display_size);
+
+cv::Mat renderPreviewSpectrum(const cv::Mat& gray_image, int max_side, cv::Size display_size);
+
+#endif // SPECTRUM_HPP
@@ -0,0 +1,25 @@
+#ifndef SWEEP_HPP
+#define SWEEP_HPP
+#include <iostream>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <QString>
+
+/**
+ * @brief 参数扫描中一个滤波器参数对应的评价结果
+ */
+struct SweepPoint
+{
+    double parameter; // 滤波器参数（高斯滤波器的sigma或理想滤波器的截止半径）
+    double mse; // 滤波重建图像与原图的均方误差
+    double psnr; // 滤波重建图像与原图的峰值信噪比
+};
+
+std::vector<SweepPoint> sweepLPF(const cv::Mat& Xkv, const cv::Mat& original,
+                                 const std::vector<double>& parameters, QString filter_type);
+
+double findMinimalBandwidth(const cv::Mat& Xkv, const cv::Mat& original, double target_psnr,
+                            double low, double high, QString filter_type, double tolerance = 1.0,
+                            std::vector<SweepPoint>* evaluated = nullptr);
+
+#endif // SWEEP_HPP
@@ -127,24 +127,21 @@ void fftShift(cv::Mat& complexImg)
 
 
 /**
- * @brief 二维快速傅里叶变换(FFT)算法
- * @param xnm 要进行变换的二维矩阵x(n,m)
- * @param type 输入二维矩阵x(n,m)的数据类型，支持的有uchar、int、complex（代表std::complex<double>）
- * @return 傅里叶变换的结果X(k,v)
+ * @brief 计算不小于n的最小的2的整数次方，作为FFT点数
+ * @param n 原序列长度
+ * @return 扩充后的FFT点数
  */
-cv::Mat FFT2D(cv::Mat xnm, QString type)
+int nextPowerOfTwo(int n)
 {
-    int N = std::max(xnm.size[0], xnm.size[1]); // FFT点数
-    if(N < 1) throw std::invalid_argument("no image");
     int M = 0; // FFT级数
-    // 如果N是2的整数次方，由对数得到M
-    if((N & (N-1)) == 0) 
+    // 如果n是2的整数次方，由对数得到M
+    if((n & (n-1)) == 0) 
     {
-        M = std::log2(N);
+        M = std::log2(n);
     }
-    else // 如果N不是2的整数次方，则将点数扩大至大于N的最小的2的整数次方
+    else // 如果n不是2的整数次方，则将点数扩大至大于n的最小的2的整数次方
     {
-        int i = N; // 给定的FFT点数
+        int i = n; // 给定的FFT点数
         int times = 0; // 右移次数
         while(i > 1)
         {
@@ -153,9 +150,19 @@ cv::Mat FFT2D(cv::Mat xnm, QString type)
         }
         M = times + 1; // 得到FFT级数
     }
-    N = 1 << M; // 扩充后的FFT点数
+    return 1 << M;
+}
 
-    // 将原二维矩阵x(n,m)补零扩充至N*N个元素，并将元素转化为复数形式
+
+/**
+ * @brief 将二维矩阵x(n,m)补零扩充至N*N个元素，并将元素转化为复数形式
+ * @param xnm 原二维矩阵x(n,m)
+ * @param N 扩充后的边长
+ * @param type 原二维矩阵x(n,m)的数据类型，支持的有uchar、int、complex（代表std::complex<double>）
+ * @return 扩充后的二维复数矩阵
+ */
+cv::Mat expandToComplex(cv::Mat xnm, int N, QString type)
+{
     cv::Mat xnm_expand = cv::Mat_<std::complex<double>>(N, N);
     xnm_expand.setTo(0);
     if(type == "uchar") // 输入二维矩阵x(n,m)的数据类型为uchar
@@ -182,6 +189,24 @@ cv::Mat FFT2D(cv::Mat xnm, QString type)
             xnm_expand.at<std::complex<double>>(i, j) = xnm.at<std::complex<double>>(i, j);
         }
     }
+    return xnm_expand;
+}
+
+
+/**
+ * @brief 二维快速傅里叶变换(FFT)算法
+ * @param xnm 要进行变换的二维矩阵x(n,m)
+ * @param type 输入二维矩阵x(n,m)的数据类型，支持的有uchar、int、complex（代表std::complex<double>）
+ * @return 傅里叶变换的结果X(k,v)
+ */
+cv::Mat FFT2D(cv::Mat xnm, QString type)
+{
+    int N = std::max(xnm.size[0], xnm.size[1]); // FFT点数
+    if(N < 1) throw std::invalid_argument("no image");
+    N = nextPowerOfTwo(N); // 扩充后的FFT点数
+
+    // 将原二维矩阵x(n,m)补零扩充至N*N个元素，并将元素转化为复数形式
+    cv::Mat xnm_expand = expandToComplex(xnm, N, type);
 
     cv::Mat Xkm = cv::Mat_<std::complex<double>>(N, N); // 定义矩阵存储第一级FFT结果
     for(int i=0; i<N; i++) // 遍历每一列
@@ -91,6 +91,51 @@ void fftInverseShift(cv::Mat& complexImg)
 }
 
 
+/**
+ * @brief 将二维复数矩阵裁剪为原二维矩阵x(n,m)的大小，去掉补零部分，并转换为原数据类型
+ * @param xnm 二维复数矩阵，其中的元素类型为std::complex<double>
+ * @param origin_rows 原二维矩阵x(n,m)的行数
+ * @param origin_cols 原二维矩阵x(n,m)的列数
+ * @param type 原二维矩阵x(n,m)的数据类型，支持的有uchar、int、complex（代表std::complex<double>）
+ * @return 裁剪后的二维矩阵
+ */
+cv::Mat cropFromComplex(cv::Mat xnm, int origin_rows, int origin_cols, QString type)
+{
+    // 滤波后的结果可能因振铃超出原数据类型的范围，用saturate_cast四舍五入并截断到该范围内
+    if(type == "uchar")
+    {
+        cv::Mat xnm_origin = cv::Mat_<uchar>(origin_rows, origin_cols);
+        for(int i=0; i<origin_rows; i++)
+        for(int j=0; j<origin_cols; j++)
+        {
+            xnm_origin.at<uchar>(i, j) = cv::saturate_cast<uchar>(xnm.at<std::complex<double>>(i, j).real());
+        }
+        return xnm_origin;
+    }
+    else if(type == "int")
+    {
+        cv::Mat xnm_origin = cv::Mat_<int>(origin_rows, origin_cols);
+        for(int i=0; i<origin_rows; i++)
+        for(int j=0; j<origin_cols; j++)
+        {
+            xnm_origin.at<int>(i, j) = cv::saturate_cast<int>(xnm.at<std::complex<double>>(i, j).real());
+        }
+        return xnm_origin;
+    }
+    else if(type == "complex")
+    {
+        cv::Mat xnm_origin = cv::Mat_<std::complex<double>>(origin_rows, origin_cols);
+        for(int i=0; i<origin_rows; i++)
+        for(int j=0; j<origin_cols; j++)
+        {
+            xnm_origin.at<std::complex<double>>(i, j) = xnm.at<std::complex<double>>(i, j);
+        }
+        return xnm_origin;
+    }
+    return xnm;
+}
+
+
 /**
  * @brief 二维快速傅里叶逆变换(IFFT)算法
  * @param xnm 要进行变换的二维矩阵X(k,v)，
@@ -102,9 +147,9 @@ void fftInverseShift(cv::Mat& complexImg)
  */
 cv::Mat IFFT2D(cv::Mat Xkv, int origin_rows, int origin_cols, QString type)
 {
-    fftInverseShift(Xkv); // 逆中心化
-    int N=Xkv.size[0];
     cv::Mat Xkv_expand = Xkv.clone();
+    fftInverseShift(Xkv_expand); // 逆中心化，在副本上进行，不修改调用者传入的频谱
+    int N=Xkv_expand.size[0];
 
     cv::Mat xnv = cv::Mat_<std::complex<double>>(N, N); // 定义矩阵存储第一级IFFT结果
     for(int i=0; i<N; i++) // 遍历每一列
@@ -129,37 +174,7 @@ cv::Mat IFFT2D(cv::Mat Xkv, int origin_rows, int origin_cols, QString type)
     }
 
     // 裁剪结果矩阵，去掉补零部分
-    if(type == "uchar")
-    {
-        cv::Mat xnm_origin = cv::Mat_<uchar>(origin_rows, origin_cols);
-        for(int i=0; i<origin_rows; i++)
-        for(int j=0; j<origin_cols; j++)
-        {
-            xnm_origin.at<uchar>(i, j) = static_cast<uchar>(xnm.at<std::complex<double>>(i, j).real());
-        }
-        return xnm_origin;
-    }
-    else if(type == "int")
-    {
-        cv::Mat xnm_origin = cv::Mat_<int>(origin_rows, origin_cols);
-        for(int i=0; i<origin_rows; i++)
-        for(int j=0; j<origin_cols; j++)
-        {
-            xnm_origin.at<int>(i, j) = static_cast<int>(xnm.at<std::complex<double>>(i, j).real());
-        }
-        return xnm_origin;
-    }
-    else if(type == "complex")
-    {
-        cv::Mat xnm_origin = cv::Mat_<std::complex<double>>(origin_rows, origin_cols);
-        for(int i=0; i<origin_rows; i++)
-        for(int j=0; j<origin_cols; j++)
-        {
-            xnm_origin.at<std::complex<double>>(i, j) = xnm.at<std::complex<double>>(i, j);
-        }
-        return xnm_origin;
-    }
-    return xnm;
+    return cropFromComplex(xnm, origin_rows, origin_cols, type);
 }
 
 
@@ -196,6 +211,7 @@ cv::Mat createGaussianLPF(cv::Size size, float sigma)
 cv::Mat createIdealLPF(cv::Size size, float cutoffRadius) 
 {
     cv::Mat filter = cv::Mat_<std::complex<double>>(size);
+    filter.setTo(0); // 截止频率外的频率被滤除
     cv::Point center(size.width / 2, size.height / 2);
 
     for (int i = 0; i < size.height; i++) {
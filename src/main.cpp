@@ -1,8 +1,75 @@
 #include "widget.hpp"
+#include "slab.hpp"
+#include "planner.hpp"
 #include <QApplication>
+#include <QDir>
+#include <cstdlib>
+#include <string>
+
+/**
+ * @brief wisdom文件路径，优先使用环境变量FFT_WISDOM，否则为用户主目录下的.fft-ifft-2d-wisdom
+ */
+static QString wisdomPath()
+{
+    QByteArray path = qgetenv("FFT_WISDOM");
+    if(!path.isEmpty()) return QString::fromLocal8Bit(path);
+    return QDir::homePath() + "/.fft-ifft-2d-wisdom";
+}
+
 
 int main(int argc, char *argv[])
 {
+    // 启动时读取之前测得的执行计划，文件不存在时所有点数都按经验规则选择
+    loadWisdom(wisdomPath());
+
+    // 命令行参数 --plan N1 N2 ...：不启动界面，测量各点数下最快的执行计划并写入wisdom文件
+    if(argc >= 2 && std::string(argv[1]) == "--plan")
+    {
+        cv::setNumThreads(0); // 关闭OpenCV的线程池，保证测量多进程计划时是在单线程的进程中fork
+        try
+        {
+            for(int i=2; i<argc; i++)
+            {
+                FFTPlan plan = planFFT2D(std::atoi(argv[i]), PLANNER_MEASURE, true);
+                std::cout << plan.N << "\t" << plan.strategy.toStdString() << "\t" << plan.workers << "\t" << plan.seconds << std::endl;
+            }
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        if(!saveWisdom(wisdomPath()))
+        {
+            std::cerr << "failed to write " << wisdomPath().toStdString() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // 命令行参数 --slab-benchmark [N] [P]：不启动界面，测试多进程FFT2D在1~P个进程下的扩展效率
+    if(argc >= 2 && std::string(argv[1]) == "--slab-benchmark")
+    {
+        int N = argc >= 3 ? std::atoi(argv[2]) : 512;
+        int P = argc >= 4 ? std::atoi(argv[3]) : 4;
+        try
+        {
+            std::vector<SlabScaling> results = benchmarkSlabFFT2D(N, P, 3);
+            std::cout << "processes\tseconds\tspeedup\tefficiency\tmax_error\troundtrip_error" << std::endl;
+            for(const SlabScaling& scaling : results)
+            {
+                std::cout << scaling.processes << "\t" << scaling.seconds << "\t" << scaling.speedup << "\t"
+                          << scaling.efficiency << "\t" << scaling.max_error << "\t" << scaling.roundtrip_error << std::endl;
+            }
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
     QApplication a(argc, argv);
     Widget w;
     w.show();
@@ -0,0 +1,260 @@
+#include "pipeline.hpp"
+#include "fft.hpp"
+#include "ifft.hpp"
+#include "spectrum.hpp"
+#include <complex>
+
+
+/**
+ * @brief 数据流图的构造函数，所有节点初始均为失效状态
+ */
+ProcessingGraph::ProcessingGraph() : sigma(0), show_phase(false), recoveredMSE(0), recoveredPSNR(0), lpfMSE(0), lpfPSNR(0)
+{
+    for(int i=0; i<NODE_COUNT; i++)
+    {
+        valid[i] = false;
+    }
+}
+
+
+/**
+ * @brief 使一个节点及其所有下游节点的缓存失效
+ * @param node 要失效的节点
+ */
+void ProcessingGraph::invalidate(Node node)
+{
+    valid[node] = false;
+    switch(node)
+    {
+        case NODE_GRAY:
+            invalidate(NODE_SPECTRUM);
+            invalidate(NODE_METRICS);
+            invalidate(NODE_FILTERED_METRICS);
+            break;
+        case NODE_SPECTRUM:
+            invalidate(NODE_SPECTRUM_IMAGE);
+            invalidate(NODE_FILTER);
+            invalidate(NODE_RECOVERED);
+            break;
+        case NODE_FILTER:
+            invalidate(NODE_FILTERED_RECOVERED);
+            break;
+        case NODE_RECOVERED:
+            invalidate(NODE_METRICS);
+            break;
+        case NODE_FILTERED_RECOVERED:
+            invalidate(NODE_FILTERED_METRICS);
+            break;
+        default:
+            break;
+    }
+}
+
+
+/**
+ * @brief 设置输入图像路径，即使路径不变也会重新读取，因此所有节点都会失效
+ * @param file_path 输入图像路径
+ */
+void ProcessingGraph::setFilePath(QString file_path)
+{
+    this->file_path = file_path;
+    invalidate(NODE_GRAY);
+}
+
+
+/**
+ * @brief 设置高斯低通滤波器的sigma，只有滤波器及其下游节点会失效
+ * @param sigma 高斯低通滤波器的sigma
+ */
+void ProcessingGraph::setSigma(int sigma)
+{
+    if(sigma == this->sigma) return;
+    this->sigma = sigma;
+    invalidate(NODE_FILTER);
+}
+
+
+/**
+ * @brief 设置频谱图的显示尺寸，只有频谱图节点会失效
+ * @param display_size 频谱图的显示尺寸
+ */
+void ProcessingGraph::setDisplaySize(cv::Size display_size)
+{
+    if(display_size == this->display_size) return;
+    this->display_size = display_size;
+    invalidate(NODE_SPECTRUM_IMAGE);
+}
+
+
+/**
+ * @brief 设置频谱图显示相位谱还是对数幅度谱，只有频谱图节点会失效
+ * @param show_phase 为true时显示相位谱，否则显示对数幅度谱
+ */
+void ProcessingGraph::setShowPhase(bool show_phase)
+{
+    if(show_phase == this->show_phase) return;
+    this->show_phase = show_phase;
+    invalidate(NODE_SPECTRUM_IMAGE);
+}
+
+
+/**
+ * @brief 读取图像并转换为灰度图，路径为空或图像不存在时为空矩阵
+ */
+const cv::Mat& ProcessingGraph::gray()
+{
+    if(!valid[NODE_GRAY])
+    {
+        // 路径为空时不调用imread，避免OpenCV输出无法读取文件的警告
+        cv::Mat image;
+        if(!file_path.isEmpty()) image = cv::imread(file_path.toStdString());
+        if(image.empty()) gray_image.release();
+        else cv::cvtColor(image, gray_image, cv::COLOR_BGR2GRAY);
+        valid[NODE_GRAY] = true;
+    }
+    return gray_image;
+}
+
+
+/**
+ * @brief 对灰度图进行FFT运算得到的频域复数矩阵，执行计划优先取自wisdom
+ */
+const cv::Mat& ProcessingGraph::spectrum()
+{
+    if(!valid[NODE_SPECTRUM])
+    {
+        gray();
+        if(gray_image.empty())
+        {
+            Xkv.release();
+        }
+        else
+        {
+            plan = planFFT2D(std::max(gray_image.rows, gray_image.cols), PLANNER_ESTIMATE);
+            Xkv = executeFFT2D(plan, gray_image, "uchar");
+        }
+        valid[NODE_SPECTRUM] = true;
+    }
+    return Xkv;
+}
+
+
+/**
+ * @brief 按显示尺寸生成的8位对数幅度谱或相位谱
+ */
+const cv::Mat& ProcessingGraph::spectrumImage()
+{
+    if(!valid[NODE_SPECTRUM_IMAGE])
+    {
+        spectrum();
+        if(Xkv.empty()) Xkv_8u.release();
+        else if(show_phase) Xkv_8u = renderPhaseSpectrum(Xkv, display_size);
+        else Xkv_8u = renderMagnitudeSpectrum(Xkv, display_size);
+        valid[NODE_SPECTRUM_IMAGE] = true;
+    }
+    return Xkv_8u;
+}
+
+
+/**
+ * @brief 与频谱尺寸相同的二维高斯低通滤波器
+ */
+const cv::Mat& ProcessingGraph::filter()
+{
+    if(!valid[NODE_FILTER])
+    {
+        spectrum();
+        if(Xkv.empty()) lpf.release();
+        else lpf = createGaussianLPF(cv::Size(Xkv.cols, Xkv.rows), sigma);
+        valid[NODE_FILTER] = true;
+    }
+    return lpf;
+}
+
+
+/**
+ * @brief 重建图像
+ * @param filtered 为true时先对频谱进行低通滤波再IFFT，否则直接IFFT
+ */
+const cv::Mat& ProcessingGraph::recovered(bool filtered)
+{
+    if(!filtered)
+    {
+        if(!valid[NODE_RECOVERED])
+        {
+            spectrum();
+            if(Xkv.empty()) xnm_recovered.release();
+            else xnm_recovered = executeIFFT2D(plan, Xkv, gray_image.rows, gray_image.cols, "uchar");
+            valid[NODE_RECOVERED] = true;
+        }
+        return xnm_recovered;
+    }
+
+    if(!valid[NODE_FILTERED_RECOVERED])
+    {
+        spectrum();
+        filter();
+        if(Xkv.empty())
+        {
+            xnm_filtered_recovered.release();
+        }
+        else
+        {
+            // 将频域图与滤波器逐项相乘，得到滤波后的频域图
+            cv::Mat Xkv_filtered = cv::Mat_<std::complex<double>>(Xkv.size());
+            for(int i=0; i<Xkv.rows; i++)
+            {
+                const std::complex<double>* src = Xkv.ptr<std::complex<double>>(i);
+                const std::complex<double>* h = lpf.ptr<std::complex<double>>(i);
+                std::complex<double>* dst = Xkv_filtered.ptr<std::complex<double>>(i);
+                for(int j=0; j<Xkv.cols; j++)
+                {
+                    dst[j] = src[j] * h[j];
+                }
+            }
+            xnm_filtered_recovered = executeIFFT2D(plan, Xkv_filtered, gray_image.rows, gray_image.cols, "uchar");
+        }
+        valid[NODE_FILTERED_RECOVERED] = true;
+    }
+    return xnm_filtered_recovered;
+}
+
+
+/**
+ * @brief 计算重建图像与原图的MSE和PSNR，没有图像时均为0
+ * @param filtered 为true时计算滤波重建图像的，否则计算直接重建图像的
+ */
+void ProcessingGraph::computeMetrics(bool filtered)
+{
+    const Node node = filtered ? NODE_FILTERED_METRICS : NODE_METRICS;
+    if(valid[node]) return;
+
+    const cv::Mat& reconstructed = recovered(filtered);
+    double& MSE = filtered ? lpfMSE : recoveredMSE;
+    double& PSNR = filtered ? lpfPSNR : recoveredPSNR;
+    MSE = reconstructed.empty() ? 0 : computeMSE(gray(), reconstructed);
+    PSNR = reconstructed.empty() ? 0 : computePSNR(gray(), reconstructed);
+    valid[node] = true;
+}
+
+
+/**
+ * @brief 重建图像与原图的均方误差
+ * @param filtered 为true时为滤波重建图像的，否则为直接重建图像的
+ */
+double ProcessingGraph::mse(bool filtered)
+{
+    computeMetrics(filtered);
+    return filtered ? lpfMSE : recoveredMSE;
+}
+
+
+/**
+ * @brief 重建图像与原图的峰值信噪比
+ * @param filtered 为true时为滤波重建图像的，否则为直接重建图像的
+ */
+double ProcessingGraph::psnr(bool filtered)
+{
+    computeMetrics(filtered);
+    return filtered ? lpfPSNR : recoveredPSNR;
+}
@@ -0,0 +1,274 @@
+#include "planner.hpp"
+#include "fft.hpp"
+#include "ifft.hpp"
+#include "slab.hpp"
+#include <complex>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+
+
+static std::map<int, FFTPlan> wisdom; // 已知的最优计划，以FFT点数为键
+static std::mutex wisdom_mutex; // 保护wisdom的互斥锁
+
+
+/**
+ * @brief 构造一个执行计划
+ */
+static FFTPlan makePlan(int N, QString strategy, int workers)
+{
+    FFTPlan plan;
+    plan.N = N;
+    plan.strategy = strategy;
+    plan.workers = workers;
+    plan.seconds = 0;
+    return plan;
+}
+
+
+/**
+ * @brief 用threads个线程对N*N复数矩阵的每一行做一维FFT或IFFT，每个线程负责连续的一段行
+ * @param data N*N的复数矩阵，其中的元素类型为std::complex<double>
+ * @param threads 线程数
+ * @param inverse 为true时做IFFT，否则做FFT
+ */
+static void transformRowsThreaded(cv::Mat& data, int threads, bool inverse)
+{
+    const int N = data.rows;
+    std::vector<std::thread> pool;
+    for(int t=0; t<threads; t++)
+    {
+        pool.emplace_back([&data, N, threads, inverse, t]()
+        {
+            for(int i=t*N/threads; i<(t+1)*N/threads; i++)
+            {
+                cv::Mat row = data.row(i);
+                cv::Mat result = inverse ? IFFT(row, N) : FFT(row, N, "complex");
+                result.copyTo(row);
+            }
+        });
+    }
+    for(std::thread& thread : pool) thread.join();
+}
+
+
+/**
+ * @brief 多线程二维FFT/IFFT（不含中心化）：行变换 -> 分块转置 -> 行变换（即列变换） -> 转置回原布局
+ *        与FFT2D逐列取出再变换相比，转置后按行访问内存是连续的
+ * @param data N*N的复数矩阵，结果写回该矩阵
+ * @param threads 线程数，超过N时按N处理
+ * @param inverse 为true时做IFFT，否则做FFT
+ */
+static void threadedTransform(cv::Mat& data, int threads, bool inverse)
+{
+    threads = std::max(1, std::min(threads, data.rows));
+    transformRowsThreaded(data, threads, inverse);
+    cv::transpose(data, data);
+    transformRowsThreaded(data, threads, inverse);
+    cv::transpose(data, data);
+}
+
+
+/**
+ * @brief 按执行计划进行二维快速傅里叶变换(FFT)，结果与FFT2D相同
+ * @param plan 由planFFT2D得到的执行计划
+ * @param xnm 要进行变换的二维矩阵x(n,m)
+ * @param type 输入二维矩阵x(n,m)的数据类型，支持的有uchar、int、complex（代表std::complex<double>）
+ * @return 傅里叶变换的结果X(k,v)
+ */
+cv::Mat executeFFT2D(const FFTPlan& plan, cv::Mat xnm, QString type)
+{
+    int N = std::max(xnm.size[0], xnm.size[1]); // FFT点数
+    if(N < 1) throw std::invalid_argument("no image");
+    N = nextPowerOfTwo(N); // 扩充后的FFT点数
+    if(N != plan.N) throw std::invalid_argument("plan does not match x(n,m) size");
+
+    if(plan.strategy == "slab") return FFT2DSlab(xnm, type, plan.workers);
+    if(plan.strategy != "threaded") return FFT2D(xnm, type);
+
+    cv::Mat Xkv = expandToComplex(xnm, N, type);
+    threadedTransform(Xkv, plan.workers, false);
+    fftShift(Xkv); // 进行中心化
+    return Xkv;
+}
+
+
+/**
+ * @brief 按执行计划进行二维快速傅里叶逆变换(IFFT)，结果与IFFT2D相同
+ * @param plan 由planFFT2D得到的执行计划
+ * @param Xkv 要进行逆变换的二维矩阵X(k,v)，
+ *           其中的元素类型为std::complex<double>（实部虚部都为双精度浮点数的复数）
+ * @param origin_rows 原二维矩阵x(n,m)的行数
+ * @param origin_cols 原二维矩阵x(n,m)的列数
+ * @param type 原二维矩阵x(n,m)的数据类型，支持的有uchar、int、complex（代表std::complex<double>）
+ * @return 傅里叶逆变换的结果x(n,m)，大小将裁剪为与进行FFT时的原二维矩阵x(n,m)相同
+ */
+cv::Mat executeIFFT2D(const FFTPlan& plan, cv::Mat Xkv, int origin_rows, int origin_cols, QString type)
+{
+    if(Xkv.rows != plan.N) throw std::invalid_argument("plan does not match X(k,v) size");
+
+    if(plan.strategy == "slab") return IFFT2DSlab(Xkv, origin_rows, origin_cols, type, plan.workers);
+    if(plan.strategy != "threaded") return IFFT2D(Xkv, origin_rows, origin_cols, type);
+
+    cv::Mat xnm = Xkv.clone();
+    fftInverseShift(xnm); // 逆中心化
+    threadedTransform(xnm, plan.workers, true);
+    return cropFromComplex(xnm, origin_rows, origin_cols, type);
+}
+
+
+/**
+ * @brief 列出MEASURE模式要测量的候选计划：单线程，以及线程数/进程数从2开始逐次翻倍直到CPU核数的多线程、多进程
+ * @param N FFT点数
+ * @param allow_processes 是否包含多进程计划
+ * @return 候选计划
+ */
+static std::vector<FFTPlan> candidatePlans(int N, bool allow_processes)
+{
+    const int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const int max_workers = std::min(cores, N);
+
+    std::vector<int> workers;
+    for(int w=2; w<=max_workers; w*=2) workers.push_back(w);
+    if(max_workers > 1 && (max_workers & (max_workers-1)) != 0) workers.push_back(max_workers);
+
+    std::vector<FFTPlan> plans;
+    plans.push_back(makePlan(N, "serial", 1));
+    for(int w : workers)
+    {
+        plans.push_back(makePlan(N, "threaded", w));
+        if(allow_processes) plans.push_back(makePlan(N, "slab", w));
+    }
+    return plans;
+}
+
+
+/**
+ * @brief 为N点二维FFT/IFFT选择执行计划
+ *        wisdom中已有该点数的计划时直接使用；否则ESTIMATE模式按经验规则选择，
+ *        MEASURE模式对每个候选计划在随机图像上测两次FFT2D+IFFT2D取最短耗时，选择最快的并记入wisdom
+ *        多进程计划需要在多线程的进程（如界面程序）中fork，fork后的子进程再分配内存、做运算是不安全的，
+ *        因此只有单线程的命令行程序才应允许多进程计划；不允许时wisdom中的多进程计划会换成相同线程数的多线程计划
+ * @param N 图像的最长边，会扩充至2的整数次方
+ * @param mode 规划器的工作模式
+ * @param allow_processes 是否允许选择多进程计划
+ * @return 执行计划
+ */
+FFTPlan planFFT2D(int N, PlannerMode mode, bool allow_processes)
+{
+    if(N < 1) throw std::invalid_argument("no image");
+    N = nextPowerOfTwo(N);
+
+    {
+        std::lock_guard<std::mutex> lock(wisdom_mutex);
+        std::map<int, FFTPlan>::const_iterator found = wisdom.find(N);
+        if(found != wisdom.end())
+        {
+            FFTPlan plan = found->second;
+            if(plan.strategy == "slab" && !allow_processes) plan.strategy = "threaded";
+            return plan;
+        }
+    }
+
+    if(mode == PLANNER_ESTIMATE)
+    {
+        // 小图像的线程创建开销大于收益，多进程的fork和共享内存开销更大，只在MEASURE模式下考虑
+        const int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        if(N < 256 || cores == 1) return makePlan(N, "serial", 1);
+        return makePlan(N, "threaded", std::min(cores, N));
+    }
+
+    cv::Mat image(N, N, CV_8U);
+    cv::randu(image, 0, 256);
+
+    FFTPlan best;
+    std::vector<FFTPlan> candidates = candidatePlans(N, allow_processes);
+    for(size_t k=0; k<candidates.size(); k++)
+    {
+        FFTPlan& plan = candidates[k];
+        for(int r=0; r<2; r++)
+        {
+            // 计划同时用于FFT2D和IFFT2D，因此测量一次正变换加一次逆变换的耗时
+            int64 start = cv::getTickCount();
+            executeIFFT2D(plan, executeFFT2D(plan, image, "uchar"), N, N, "uchar");
+            double seconds = (cv::getTickCount() - start) / cv::getTickFrequency();
+            if(r == 0 || seconds < plan.seconds) plan.seconds = seconds;
+        }
+        if(k == 0 || plan.seconds < best.seconds) best = plan;
+    }
+
+    std::lock_guard<std::mutex> lock(wisdom_mutex);
+    wisdom[N] = best;
+    return best;
+}
+
+
+/**
+ * @brief 从文件中读取wisdom，与已有的计划合并（同一点数以文件中的为准）
+ *        文件每行为“N strategy workers seconds”，以#开头的行为注释
+ * @param path wisdom文件路径
+ * @return 文件能打开时返回true
+ */
+bool loadWisdom(QString path)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+
+    QTextStream in(&file);
+    std::lock_guard<std::mutex> lock(wisdom_mutex);
+    while(!in.atEnd())
+    {
+        QString line = in.readLine().trimmed();
+        if(line.isEmpty() || line.startsWith("#")) continue;
+
+        QStringList fields = line.simplified().split(' ');
+        if(fields.size() != 4) continue;
+        bool ok_N = false, ok_workers = false, ok_seconds = false;
+        FFTPlan plan = makePlan(fields[0].toInt(&ok_N), fields[1], fields[2].toInt(&ok_workers));
+        plan.seconds = fields[3].toDouble(&ok_seconds);
+
+        // 忽略格式不正确的行
+        if(!ok_N || !ok_workers || !ok_seconds) continue;
+        if(plan.N < 1 || (plan.N & (plan.N-1)) != 0 || plan.workers < 1) continue;
+        if(plan.strategy != "serial" && plan.strategy != "threaded" && plan.strategy != "slab") continue;
+        wisdom[plan.N] = plan;
+    }
+    return true;
+}
+
+
+/**
+ * @brief 将当前所有计划写入wisdom文件，供之后启动的进程直接读取
+ * @param path wisdom文件路径
+ * @return 写入成功时返回true
+ */
+bool saveWisdom(QString path)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) return false;
+
+    QTextStream out(&file);
+    out << "# fft-ifft-2d wisdom: N strategy workers seconds\n";
+    std::lock_guard<std::mutex> lock(wisdom_mutex);
+    for(std::map<int, FFTPlan>::const_iterator it=wisdom.begin(); it!=wisdom.end(); ++it)
+    {
+        const FFTPlan& plan = it->second;
+        out << plan.N << " " << plan.strategy << " " << plan.workers << " " << plan.seconds << "\n";
+    }
+    out.flush();
+    return file.error() == QFile::NoError;
+}
+
+
+/**
+ * @brief 清空当前所有计划
+ */
+void forgetWisdom()
+{
+    std::lock_guard<std::mutex> lock(wisdom_mutex);
+    wisdom.clear();
+}
@@ -0,0 +1,279 @@
+#include "slab.hpp"
+#include "fft.hpp"
+#include "ifft.hpp"
+#include <complex>
+#include <stdexcept>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+/**
+ * @brief 放在共享内存开头的进程间同步数据，其后紧跟两块N*N的复数缓冲区
+ */
+struct SlabShared
+{
+    pthread_barrier_t barrier; // 进程间共享的屏障，用于等待所有进程完成同一阶段
+};
+
+
+/**
+ * @brief 对二维复数矩阵中[row_begin, row_end)的每一行做一维FFT或IFFT，结果写回原位置
+ * @param data 按行连续存储的N*N复数矩阵
+ * @param N 矩阵边长，必须是2的整数次方
+ * @param row_begin 起始行
+ * @param row_end 结束行（不含）
+ * @param inverse 为true时做IFFT，否则做FFT
+ */
+static void transformRows(std::complex<double>* data, int N, int row_begin, int row_end, bool inverse)
+{
+    for(int i=row_begin; i<row_end; i++)
+    {
+        cv::Mat row(1, N, CV_64FC2, data + static_cast<size_t>(i) * N);
+        cv::Mat result = inverse ? IFFT(row, N) : FFT(row, N, "complex");
+        result.copyTo(row);
+    }
+}
+
+
+/**
+ * @brief all-to-all转置中进程p负责的部分：依次从每个进程q的行带中取出(q, p)块，转置后放入自己的行带
+ * @param src 转置前的N*N复数矩阵
+ * @param dst 转置后的N*N复数矩阵
+ * @param N 矩阵边长
+ * @param P 进程数
+ * @param p 当前进程的编号
+ */
+static void transposeBand(const std::complex<double>* src, std::complex<double>* dst, int N, int P, int p)
+{
+    const int row_begin = p * N / P;
+    const int row_end = (p + 1) * N / P;
+    for(int q=0; q<P; q++) // 遍历每个进程的行带
+    {
+        const int col_begin = q * N / P;
+        const int col_end = (q + 1) * N / P;
+        for(int j=col_begin; j<col_end; j++)
+        for(int i=row_begin; i<row_end; i++)
+        {
+            dst[static_cast<size_t>(i) * N + j] = src[static_cast<size_t>(j) * N + i];
+        }
+    }
+}
+
+
+/**
+ * @brief 工作进程p的完整流程：本地行变换 -> all-to-all转置 -> 本地列变换（转置后即为行） -> 转置回原布局
+ * @param shared 共享的同步数据
+ * @param a 存放输入和最终结果的共享缓冲区
+ * @param b 存放转置中间结果的共享缓冲区
+ * @param N 矩阵边长
+ * @param P 进程数
+ * @param p 当前进程的编号
+ * @param inverse 为true时做IFFT，否则做FFT
+ */
+static void slabWorker(SlabShared* shared, std::complex<double>* a, std::complex<double>* b, int N, int P, int p, bool inverse)
+{
+    const int row_begin = p * N / P;
+    const int row_end = (p + 1) * N / P;
+
+    transformRows(a, N, row_begin, row_end, inverse);
+    pthread_barrier_wait(&shared->barrier); // 所有进程的行变换完成后才能转置
+
+    transposeBand(a, b, N, P, p);
+    transformRows(b, N, row_begin, row_end, inverse);
+    pthread_barrier_wait(&shared->barrier); // 所有进程都读完a、写完b后才能转置回a
+
+    transposeBand(b, a, N, P, p);
+}
+
+
+/**
+ * @brief 等待所有工作进程结束。如果有进程异常退出，其余进程会永远阻塞在屏障上，因此将它们全部结束掉
+ * @param workers 工作进程的pid
+ * @return 所有进程都正常结束时返回true
+ */
+static bool waitWorkers(std::vector<pid_t> workers)
+{
+    bool ok = true;
+    while(!workers.empty())
+    {
+        for(size_t k=0; k<workers.size(); )
+        {
+            int status = 0;
+            pid_t result = waitpid(workers[k], &status, WNOHANG);
+            if(result == 0) // 该进程还在运行
+            {
+                k++;
+                continue;
+            }
+            if(result < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            {
+                if(ok)
+                {
+                    for(pid_t pid : workers) if(pid != workers[k]) kill(pid, SIGKILL);
+                }
+                ok = false;
+            }
+            workers.erase(workers.begin() + k);
+        }
+        if(!workers.empty()) usleep(1000);
+    }
+    return ok;
+}
+
+
+/**
+ * @brief 行带分解的多进程二维FFT/IFFT（不含中心化），P个工作进程各自负责连续的N/P行，
+ *        通过共享内存进行all-to-all转置，结果写回data
+ * @param data N*N的复数矩阵，其中的元素类型为std::complex<double>，N必须是2的整数次方
+ * @param processes 工作进程数，超过N时按N处理
+ * @param inverse 为true时做IFFT，否则做FFT
+ */
+static void slabTransform(cv::Mat& data, int processes, bool inverse)
+{
+    if(processes < 1) throw std::invalid_argument("processes must be >= 1");
+    const int N = data.rows;
+    const int P = std::min(processes, N); // 每个进程至少负责一行
+
+    // 申请进程间共享的匿名内存：同步数据 + 两块N*N的复数缓冲区
+    const size_t header = (sizeof(SlabShared) + 63) / 64 * 64;
+    const size_t bytes = static_cast<size_t>(N) * N * sizeof(std::complex<double>);
+    void* memory = mmap(nullptr, header + 2 * bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(memory == MAP_FAILED) throw std::runtime_error("failed to map shared memory");
+    SlabShared* shared = static_cast<SlabShared*>(memory);
+    std::complex<double>* a = reinterpret_cast<std::complex<double>*>(static_cast<char*>(memory) + header);
+    std::complex<double>* b = a + static_cast<size_t>(N) * N;
+
+    pthread_barrierattr_t attr;
+    pthread_barrierattr_init(&attr);
+    pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    int barrier_error = pthread_barrier_init(&shared->barrier, &attr, P);
+    pthread_barrierattr_destroy(&attr);
+    if(barrier_error != 0)
+    {
+        munmap(memory, header + 2 * bytes);
+        throw std::runtime_error("failed to initialize process-shared barrier");
+    }
+
+    cv::Mat shared_data(N, N, CV_64FC2, a);
+    data.copyTo(shared_data);
+
+    std::vector<pid_t> workers;
+    bool ok = true;
+    for(int p=0; p<P; p++)
+    {
+        pid_t pid = fork();
+        if(pid == 0) // 工作进程，只做计算，结束时直接_exit，不执行父进程的析构和退出处理
+        {
+            int status = 1;
+            try
+            {
+                slabWorker(shared, a, b, N, P, p, inverse);
+                status = 0;
+            }
+            catch(...)
+            {
+            }
+            _exit(status);
+        }
+        if(pid < 0) // 进程创建失败，已创建的进程会阻塞在屏障上
+        {
+            for(pid_t worker : workers) kill(worker, SIGKILL);
+            ok = false;
+            break;
+        }
+        workers.push_back(pid);
+    }
+    ok = waitWorkers(workers) && ok;
+
+    pthread_barrier_destroy(&shared->barrier);
+    if(ok) shared_data.copyTo(data);
+    munmap(memory, header + 2 * bytes);
+    if(!ok) throw std::runtime_error("slab worker process failed");
+}
+
+
+/**
+ * @brief 多进程二维快速傅里叶变换(FFT)算法，结果与FFT2D相同
+ *        P个工作进程各自对自己的行带做行变换，经共享内存all-to-all转置后再做列变换
+ * @param xnm 要进行变换的二维矩阵x(n,m)
+ * @param type 输入二维矩阵x(n,m)的数据类型，支持的有uchar、int、complex（代表std::complex<double>）
+ * @param processes 工作进程数
+ * @return 傅里叶变换的结果X(k,v)
+ */
+cv::Mat FFT2DSlab(cv::Mat xnm, QString type, int processes)
+{
+    int N = std::max(xnm.size[0], xnm.size[1]); // FFT点数
+    if(N < 1) throw std::invalid_argument("no image");
+    N = nextPowerOfTwo(N); // 扩充后的FFT点数
+
+    cv::Mat Xkv = expandToComplex(xnm, N, type);
+    slabTransform(Xkv, processes, false);
+    fftShift(Xkv); // 进行中心化
+
+    return Xkv;
+}
+
+
+/**
+ * @brief 多进程二维快速傅里叶逆变换(IFFT)算法，结果与IFFT2D相同
+ * @param Xkv 要进行逆变换的二维矩阵X(k,v)，
+ *           其中的元素类型为std::complex<double>（实部虚部都为双精度浮点数的复数）
+ * @param origin_rows 原二维矩阵x(n,m)的行数
+ * @param origin_cols 原二维矩阵x(n,m)的列数
+ * @param type 原二维矩阵x(n,m)的数据类型，支持的有uchar、int、complex（代表std::complex<double>）
+ * @param processes 工作进程数
+ * @return 傅里叶逆变换的结果x(n,m)，大小将裁剪为与进行FFT时的原二维矩阵x(n,m)相同
+ */
+cv::Mat IFFT2DSlab(cv::Mat Xkv, int origin_rows, int origin_cols, QString type, int processes)
+{
+    cv::Mat xnm = Xkv.clone();
+    fftInverseShift(xnm); // 逆中心化
+    slabTransform(xnm, processes, true);
+
+    return cropFromComplex(xnm, origin_rows, origin_cols, type);
+}
+
+
+/**
+ * @brief 测试多进程FFT2D在不同进程数下的扩展效率
+ *        进程数从1开始逐次翻倍直到max_processes，以单进程的耗时为基准计算加速比和效率，
+ *        同时检查FFT2D的误差和IFFT2D重建的往返误差
+ * @param N 测试用随机灰度图的边长
+ * @param max_processes 最大进程数
+ * @param repeats 每个进程数重复变换的次数，取平均耗时
+ * @return 每个进程数的测试结果
+ */
+std::vector<SlabScaling> benchmarkSlabFFT2D(int N, int max_processes, int repeats)
+{
+    if(N < 1 || max_processes < 1 || repeats < 1) throw std::invalid_argument("N, max_processes and repeats must be >= 1");
+
+    cv::Mat image(N, N, CV_8U);
+    cv::randu(image, 0, 256);
+    cv::Mat reference = FFT2D(image, "uchar");
+
+    std::vector<SlabScaling> results;
+    for(int P=1; ; P=std::min(2*P, max_processes))
+    {
+        cv::Mat Xkv;
+        int64 start = cv::getTickCount();
+        for(int r=0; r<repeats; r++)
+        {
+            Xkv = FFT2DSlab(image, "uchar", P);
+        }
+        SlabScaling scaling;
+        scaling.processes = P;
+        scaling.seconds = (cv::getTickCount() - start) / cv::getTickFrequency() / repeats;
+        scaling.speedup = results.empty() ? 1.0 : results[0].seconds / scaling.seconds;
+        scaling.efficiency = scaling.speedup / P;
+        scaling.max_error = cv::norm(Xkv, reference, cv::NORM_INF);
+        // 用同样的进程数做IFFT，与原图比较，验证多进程IFFT2D的正确性
+        cv::Mat xnm = IFFT2DSlab(Xkv, N, N, "complex", P);
+        scaling.roundtrip_error = cv::norm(xnm, expandToComplex(image, N, "uchar"), cv::NORM_INF);
+        results.push_back(scaling);
+        if(P == max_processes) break;
+    }
+    return results;
+}
@@ -0,0 +1,160 @@
+#include "spectrum.hpp"
+#include "fft.hpp"
+#include <complex>
+#include <cmath>
+
+
+#define PI  std::acos(-1.0)
+
+
+/**
+ * @brief 在保持宽高比的前提下，计算频谱图在显示区域中的实际显示尺寸
+ * @param spectrum_size 频域复数矩阵的尺寸
+ * @param display_size 显示区域（如QLabel）的尺寸
+ * @return 频谱图的显示尺寸
+ */
+cv::Size fitDisplaySize(cv::Size spectrum_size, cv::Size display_size)
+{
+    if(spectrum_size.width < 1 || spectrum_size.height < 1) throw std::invalid_argument("no spectrum");
+    if(display_size.width < 1 || display_size.height < 1) return spectrum_size;
+
+    double scale = std::min(static_cast<double>(display_size.width) / spectrum_size.width,
+                            static_cast<double>(display_size.height) / spectrum_size.height);
+    int width = std::max(1, static_cast<int>(spectrum_size.width * scale));
+    int height = std::max(1, static_cast<int>(spectrum_size.height * scale));
+    return cv::Size(width, height);
+}
+
+
+/**
+ * @brief 将频域复数矩阵渲染为对数幅度谱灰度图，直接在显示分辨率上生成
+ *        每个显示像素对应频域矩阵中的一块区域，取该区域内模长的最大值，
+ *        这样缩小显示时中心的直流分量等孤立峰值不会被丢掉；
+ *        随后取log(1+|X|)并按最大最小值归一化到0~255
+ * @param Xkv 频域复数矩阵，其中的元素类型为std::complex<double>
+ * @param display_size 显示区域的尺寸，结果会按宽高比适配到该尺寸内
+ * @return 8位灰度的对数幅度谱图像
+ */
+cv::Mat renderMagnitudeSpectrum(const cv::Mat& Xkv, cv::Size display_size)
+{
+    CV_Assert(Xkv.type() == CV_64FC2);
+
+    const cv::Size size = fitDisplaySize(Xkv.size(), display_size);
+    const int rows = Xkv.rows;
+    const int cols = Xkv.cols;
+
+    // 预先计算每个显示列对应的频域列区间，避免在内层循环中重复做除法
+    std::vector<int> col_begin(size.width), col_end(size.width);
+    for(int x=0; x<size.width; x++)
+    {
+        col_begin[x] = x * cols / size.width;
+        col_end[x] = std::max(col_begin[x] + 1, (x + 1) * cols / size.width);
+    }
+
+    cv::Mat log_magnitude(size, CV_32F);
+    // 按显示行并行，各行之间互不依赖
+    cv::parallel_for_(cv::Range(0, size.height), [&](const cv::Range& range)
+    {
+        for(int y=range.start; y<range.end; y++)
+        {
+            const int row_begin = y * rows / size.height;
+            const int row_end = std::max(row_begin + 1, (y + 1) * rows / size.height);
+            float* dst = log_magnitude.ptr<float>(y);
+            for(int x=0; x<size.width; x++)
+            {
+                double max_norm = 0; // 区域内模长平方的最大值，最后只开一次方
+                for(int i=row_begin; i<row_end; i++)
+                {
+                    // 以double数组的形式访问复数，实部虚部交替存放，便于编译器向量化
+                    const double* src = Xkv.ptr<double>(i);
+                    for(int j=col_begin[x]; j<col_end[x]; j++)
+                    {
+                        const double re = src[2*j];
+                        const double im = src[2*j + 1];
+                        const double norm = re*re + im*im;
+                        max_norm = norm > max_norm ? norm : max_norm;
+                    }
+                }
+                dst[x] = static_cast<float>(std::log1p(std::sqrt(max_norm)));
+            }
+        }
+    });
+
+    cv::Mat spectrum_8u;
+    cv::normalize(log_magnitude, spectrum_8u, 0, 255, cv::NORM_MINMAX, CV_8U);
+    return spectrum_8u;
+}
+
+
+/**
+ * @brief 将频域复数矩阵渲染为相位谱灰度图，直接在显示分辨率上生成
+ *        每个显示像素取其对应区域中心处的相位，将[-PI, PI]线性映射到0~255
+ * @param Xkv 频域复数矩阵，其中的元素类型为std::complex<double>
+ * @param display_size 显示区域的尺寸，结果会按宽高比适配到该尺寸内
+ * @return 8位灰度的相位谱图像
+ */
+cv::Mat renderPhaseSpectrum(const cv::Mat& Xkv, cv::Size display_size)
+{
+    CV_Assert(Xkv.type() == CV_64FC2);
+
+    const cv::Size size = fitDisplaySize(Xkv.size(), display_size);
+    const int rows = Xkv.rows;
+    const int cols = Xkv.cols;
+    const double scale = 255.0 / (2 * PI);
+
+    cv::Mat spectrum_8u(size, CV_8U);
+    cv::parallel_for_(cv::Range(0, size.height), [&](const cv::Range& range)
+    {
+        for(int y=range.start; y<range.end; y++)
+        {
+            const std::complex<double>* src = Xkv.ptr<std::complex<double>>((2*y + 1) * rows / (2*size.height));
+            uchar* dst = spectrum_8u.ptr<uchar>(y);
+            for(int x=0; x<size.width; x++)
+            {
+                const double phase = std::arg(src[(2*x + 1) * cols / (2*size.width)]);
+                dst[x] = cv::saturate_cast<uchar>((phase + PI) * scale);
+            }
+        }
+    });
+    return spectrum_8u;
+}
+
+
+/**
+ * @brief 生成渐进显示用的低分辨率频谱预览
+ *        先用区域插值将灰度图缩小到最长边不超过max_side，再进行FFT2D。
+ *        缩小后图像的频谱只对应完整频谱中心的低频部分，每个方向上所占的比例等于该方向的缩放比例，
+ *        因此将其渲染到显示区域中居中的对应子区域内，四周为黑色，完整频谱替换上来时是同一幅图变清晰
+ * @param gray_image 灰度图，元素类型为uchar
+ * @param max_side 缩小后图像最长边的上限
+ * @param display_size 显示区域的尺寸
+ * @return 与完整频谱的显示尺寸相同的8位对数幅度谱预览；
+ *         灰度图最长边不超过max_side时完整FFT本身就足够快，不需要预览，返回空矩阵
+ */
+cv::Mat renderPreviewSpectrum(const cv::Mat& gray_image, int max_side, cv::Size display_size)
+{
+    CV_Assert(gray_image.type() == CV_8U);
+    if(max_side < 1) throw std::invalid_argument("max_side must be >= 1");
+
+    int side = std::max(gray_image.rows, gray_image.cols);
+    if(side <= max_side) return cv::Mat();
+
+    cv::Mat small_image;
+    double scale = static_cast<double>(max_side) / side;
+    cv::Size small_size(std::max(1, static_cast<int>(gray_image.cols * scale)),
+                        std::max(1, static_cast<int>(gray_image.rows * scale)));
+    cv::resize(gray_image, small_image, small_size, 0, 0, cv::INTER_AREA);
+
+    // 完整频谱的显示尺寸，以及预览在其中对应的子区域尺寸
+    int N = nextPowerOfTwo(side);
+    cv::Size size = fitDisplaySize(cv::Size(N, N), display_size);
+    cv::Size band_size(std::max(1, size.width * small_size.width / gray_image.cols),
+                       std::max(1, size.height * small_size.height / gray_image.rows));
+    cv::Mat band_8u = renderMagnitudeSpectrum(FFT2D(small_image, "uchar"), band_size);
+
+    // 居中放置，使两者的直流分量在同一位置
+    cv::Mat preview_8u = cv::Mat::zeros(size, CV_8U);
+    cv::Rect band((size.width - band_8u.cols) / 2, (size.height - band_8u.rows) / 2, band_8u.cols, band_8u.rows);
+    band_8u.copyTo(preview_8u(band));
+    return preview_8u;
+}
@@ -0,0 +1,180 @@
+#include "sweep.hpp"
+#include "ifft.hpp"
+#include <complex>
+#include <cmath>
+
+
+/**
+ * @brief 计算中心化频谱上每一点到中心的距离平方，所有滤波器参数共用这一张表
+ *        中心的位置与createGaussianLPF、createIdealLPF保持一致
+ * @param size 频域复数矩阵的尺寸
+ * @return 距离平方矩阵，元素类型为double
+ */
+static cv::Mat squaredDistanceMap(cv::Size size)
+{
+    cv::Mat distance2 = cv::Mat_<double>(size);
+    cv::Point center(size.width / 2, size.height / 2);
+    for(int i=0; i<size.height; i++)
+    {
+        double* dst = distance2.ptr<double>(i);
+        for(int j=0; j<size.width; j++)
+        {
+            dst[j] = (i - center.y) * (i - center.y) + (j - center.x) * (j - center.x);
+        }
+    }
+    return distance2;
+}
+
+
+/**
+ * @brief 用给定参数的低通滤波器对频谱进行滤波，滤波器的值由距离平方表直接算出，不单独生成滤波器矩阵
+ * @param Xkv 中心化的频域复数矩阵
+ * @param distance2 距离平方表
+ * @param parameter 高斯滤波器的sigma或理想滤波器的截止半径
+ * @param filter_type 滤波器类型，支持的有gaussian、ideal
+ * @return 滤波后的频域复数矩阵
+ */
+static cv::Mat applyLPF(const cv::Mat& Xkv, const cv::Mat& distance2, double parameter, const QString& filter_type)
+{
+    const bool gaussian = (filter_type == "gaussian");
+    const double d0 = 2 * parameter * parameter; // 高斯滤波器的控制截止频率
+    const double radius2 = parameter * parameter; // 理想滤波器截止半径的平方
+
+    cv::Mat Xkv_filtered = cv::Mat_<std::complex<double>>(Xkv.size());
+    for(int i=0; i<Xkv.rows; i++)
+    {
+        const std::complex<double>* src = Xkv.ptr<std::complex<double>>(i);
+        const double* d = distance2.ptr<double>(i);
+        std::complex<double>* dst = Xkv_filtered.ptr<std::complex<double>>(i);
+        for(int j=0; j<Xkv.cols; j++)
+        {
+            double h = 0;
+            if(gaussian) h = d0 > 0 ? std::exp(-d[j] / d0) : (d[j] == 0 ? 1 : 0);
+            else h = d[j] <= radius2 ? 1 : 0;
+            dst[j] = src[j] * h;
+        }
+    }
+    return Xkv_filtered;
+}
+
+
+/**
+ * @brief 并行地评估一批滤波器参数，每个参数各自完成滤波、IFFT2D和MSE/PSNR计算
+ * @param Xkv 中心化的频域复数矩阵
+ * @param original 原灰度图
+ * @param distance2 距离平方表
+ * @param parameters 要评估的滤波器参数
+ * @param filter_type 滤波器类型，支持的有gaussian、ideal
+ * @return 与parameters一一对应的评价结果
+ */
+static std::vector<SweepPoint> evaluateBatch(const cv::Mat& Xkv, const cv::Mat& original, const cv::Mat& distance2,
+                                             const std::vector<double>& parameters, const QString& filter_type)
+{
+    std::vector<SweepPoint> curve(parameters.size());
+    // 各参数之间互不依赖，交给OpenCV的线程池，每个线程同时只持有一份滤波后的频谱
+    cv::parallel_for_(cv::Range(0, static_cast<int>(parameters.size())), [&](const cv::Range& range)
+    {
+        for(int k=range.start; k<range.end; k++)
+        {
+            cv::Mat Xkv_filtered = applyLPF(Xkv, distance2, parameters[k], filter_type);
+            cv::Mat xnm_filtered_recovered = IFFT2D(Xkv_filtered, original.rows, original.cols, "uchar");
+            curve[k].parameter = parameters[k];
+            curve[k].mse = computeMSE(original, xnm_filtered_recovered);
+            curve[k].psnr = computePSNR(original, xnm_filtered_recovered);
+        }
+    });
+    return curve;
+}
+
+
+/**
+ * @brief 检查参数扫描的输入是否合法
+ */
+static void checkSweepInput(const cv::Mat& Xkv, const cv::Mat& original, const QString& filter_type)
+{
+    if(Xkv.empty() || original.empty()) throw std::invalid_argument("no image");
+    CV_Assert(Xkv.type() == CV_64FC2 && original.type() == CV_8U);
+    if(filter_type != "gaussian" && filter_type != "ideal") throw std::invalid_argument("filter type must be gaussian or ideal");
+}
+
+
+/**
+ * @brief 对同一份频谱批量扫描一组低通滤波器参数，得到PSNR/MSE随参数变化的曲线
+ * @param Xkv 中心化的频域复数矩阵，即FFT2D的结果
+ * @param original 原灰度图，元素类型为uchar
+ * @param parameters 要扫描的参数，高斯滤波器为sigma，理想滤波器为截止半径
+ * @param filter_type 滤波器类型，支持的有gaussian、ideal
+ * @return 与parameters一一对应的评价结果
+ */
+std::vector<SweepPoint> sweepLPF(const cv::Mat& Xkv, const cv::Mat& original,
+                                 const std::vector<double>& parameters, QString filter_type)
+{
+    checkSweepInput(Xkv, original, filter_type);
+    cv::Mat distance2 = squaredDistanceMap(Xkv.size());
+    return evaluateBatch(Xkv, original, distance2, parameters, filter_type);
+}
+
+
+/**
+ * @brief 在[low, high]区间内搜索使PSNR达到目标值的最小带宽（sigma或截止半径）
+ *        单线程时即为二分查找；有多个线程时每轮并行评估多个等分点，区间缩小得更快。
+ *        每轮区间至少缩小为原来的1/(探测点数+1)，因此无论PSNR曲线形状如何都会收敛。
+ *        高斯滤波器的PSNR随sigma单调不减，结果即为全局最小带宽；理想滤波器的振铃会使PSNR曲线出现小幅波动，
+ *        此时结果是一个局部最小带宽：它满足目标，而比它小tolerance以上的最近探测点不满足
+ * @param Xkv 中心化的频域复数矩阵，即FFT2D的结果
+ * @param original 原灰度图，元素类型为uchar
+ * @param target_psnr 目标PSNR（dB）
+ * @param low 搜索区间下限
+ * @param high 搜索区间上限
+ * @param filter_type 滤波器类型，支持的有gaussian、ideal
+ * @param tolerance 搜索精度，区间长度小于它时停止
+ * @param evaluated 如果不为空，则追加记录搜索过程中评估过的所有点
+ * @return 满足目标PSNR的最小带宽；如果high也达不到目标则返回-1
+ */
+double findMinimalBandwidth(const cv::Mat& Xkv, const cv::Mat& original, double target_psnr,
+                            double low, double high, QString filter_type, double tolerance,
+                            std::vector<SweepPoint>* evaluated)
+{
+    checkSweepInput(Xkv, original, filter_type);
+    if(low > high) throw std::invalid_argument("low must be <= high");
+    if(tolerance <= 0) throw std::invalid_argument("tolerance must be > 0");
+
+    cv::Mat distance2 = squaredDistanceMap(Xkv.size());
+    auto evaluate = [&](const std::vector<double>& parameters) -> std::vector<SweepPoint>
+    {
+        std::vector<SweepPoint> points = evaluateBatch(Xkv, original, distance2, parameters, filter_type);
+        if(evaluated) evaluated->insert(evaluated->end(), points.begin(), points.end());
+        return points;
+    };
+
+    // 先评估区间两端
+    std::vector<SweepPoint> ends = evaluate({low, high});
+    if(ends[0].psnr >= target_psnr) return low;
+    if(ends[1].psnr < target_psnr) return -1;
+
+    const int probes_per_round = std::max(1, std::min(cv::getNumThreads(), 8));
+    while(high - low > tolerance)
+    {
+        std::vector<double> probes;
+        for(int i=1; i<=probes_per_round; i++)
+        {
+            probes.push_back(low + (high - low) * i / (probes_per_round + 1));
+        }
+        std::vector<SweepPoint> points = evaluate(probes);
+
+        // 目标点位于最后一个未达标的探测点和第一个达标的探测点之间
+        double new_low = low, new_high = high;
+        for(size_t i=0; i<points.size(); i++)
+        {
+            if(points[i].psnr >= target_psnr)
+            {
+                new_high = probes[i];
+                break;
+            }
+            new_low = probes[i];
+        }
+        low = new_low;
+        high = new_high;
+    }
+    return high;
+}
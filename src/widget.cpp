@@ -6,9 +6,14 @@
 #include <QImage>
 #include "fft.hpp"
 #include "ifft.hpp"
+#include "spectrum.hpp"
+#include "sweep.hpp"
 #include <QRadioButton>
+#include <QCheckBox>
 #include <QSlider>
 #include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QMessageBox>
 
 
 /**
@@ -25,11 +30,14 @@ Widget::Widget(QWidget *parent) : QWidget(parent), ui(new Ui::Widget)
     ui->sigma_slider->hide();
     ui->sigma_value->hide();
 
-    // 将按钮、是否滤波选项按钮组、滑动条、数值框指定事件信号与槽函数连接
+    // 将按钮、是否滤波选项按钮组、相位谱选项、滑动条、数值框、参数搜索按钮指定事件信号与槽函数连接
     connect(ui->enter_ok, &QPushButton::clicked, this, &Widget::on_enter_ok_clicked);
     connect(ui->without_lpf, &QRadioButton::toggled, this, &Widget::on_without_lpf_stateChanged);
+    connect(ui->show_phase, &QCheckBox::toggled, this, &Widget::on_show_phase_stateChanged);
     connect(ui->sigma_slider, &QSlider::valueChanged, this, &Widget::on_with_sigma_slider_valueChanged);
     connect(ui->sigma_value, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &Widget::on_with_sigma_value_valueChanged);
+    connect(ui->find_sigma, &QPushButton::clicked, this, &Widget::on_find_sigma_clicked);
+    connect(ui->sweep_sigma, &QPushButton::clicked, this, &Widget::on_sweep_sigma_clicked);
 }
 
 
@@ -43,86 +51,46 @@ Widget::~Widget()
 
 
 /**
- * @brief OK按钮的槽函数，点击按钮后自动进行FFT和IFFT运算并计算MSE和PSNR
+ * @brief OK按钮的槽函数，点击按钮后显示灰度图和频谱图，重建图像及其MSE和PSNR只计算当前选项要显示的那一个
  */
 void Widget::on_enter_ok_clicked()
 {
     // 从输入路径读取文件，如果文件不存在则依然显示No Image
-    QString file_path = ui->file_path->text();
-    QPixmap file(file_path);
+    graph.setFilePath(ui->file_path->text());
+    graph.setSigma(ui->sigma_value->value());
+    graph.setDisplaySize(cv::Size(ui->fft_image->width(), ui->fft_image->height()));
+    graph.setShowPhase(ui->show_phase->isChecked());
+    const cv::Mat& gray_image = graph.gray();
     // 如果文件存在，则将原始图像转换为灰度图显示在左边
-    if(!file.isNull())
+    if(!gray_image.empty())
     {
-        // 读取图像
-        cv::Mat image = cv::imread(file_path.toStdString());
-        // RGB图像转换为灰度图
-        cv::cvtColor(image, gray_image, cv::COLOR_BGR2GRAY);
         // 显示灰度图
         QImage gray_image_toshow(gray_image.data, gray_image.cols, gray_image.rows, gray_image.step, QImage::Format_Grayscale8);
         QPixmap raw_image_pixmap = QPixmap::fromImage(gray_image_toshow);
         ui->raw_image->setPixmap(raw_image_pixmap);
 
-        // 对灰度图进行FFT运算，得到频域复数矩阵
-        Xkv = FFT2D(gray_image, "uchar");
-        // 将频域复数矩阵每项取模长，得到幅频矩阵
-        cv::Mat Xkv_abs = cv::Mat_<double>(Xkv.size());
-        for(int i=0; i<Xkv.size[0]; i++)
+        // 渐进显示：先对缩小后的灰度图做FFT，立即显示低分辨率的对数幅度谱预览
+        // 图像较小时完整FFT本身就很快，不生成预览；相位谱没有对应的低分辨率近似，也不生成预览
+        cv::Mat preview_8u;
+        if(ui->progressive_preview->isChecked() && !ui->show_phase->isChecked())
         {
-            for(int j=0; j<Xkv.size[1]; j++)
-            {
-                Xkv_abs.at<double>(i, j) = std::abs(Xkv.at<std::complex<double>>(i, j));
-            }
+            preview_8u = renderPreviewSpectrum(gray_image, 128, cv::Size(ui->fft_image->width(), ui->fft_image->height()));
+        }
+        if(!preview_8u.empty())
+        {
+            QImage preview_8u_toshow(preview_8u.data, preview_8u.cols, preview_8u.rows, preview_8u.step, QImage::Format_Grayscale8);
+            ui->fft_image->setPixmap(QPixmap::fromImage(preview_8u_toshow));
+            ui->fft_image->repaint(); // 完整FFT会阻塞事件循环，因此立即重绘
         }
 
-        // 将幅频矩阵归一化为灰度图并显示出来
-        cv::Mat Xkv_8u;
-        cv::convertScaleAbs(Xkv_abs, Xkv_8u);
+        // 对灰度图进行FFT运算，直接在显示分辨率上生成对数幅度谱或相位谱，替换掉预览图
+        const cv::Mat& Xkv_8u = graph.spectrumImage();
         QImage Xkv_8u_toshow(Xkv_8u.data, Xkv_8u.cols, Xkv_8u.rows, Xkv_8u.step, QImage::Format_Grayscale8);
         QPixmap Xkv_8u_pixmap = QPixmap::fromImage(Xkv_8u_toshow);
         ui->fft_image->setPixmap(Xkv_8u_pixmap);
 
-        // 直接对频谱图进行IFFT，得到复原图像
-        cv::Mat xnm_recovered = IFFT2D(Xkv, gray_image.size[0], gray_image.size[1], "uchar");
-        QImage recovered_image_toshow(xnm_recovered.data, xnm_recovered.cols, xnm_recovered.rows, xnm_recovered.step, QImage::Format_Grayscale8);
-        recovered_image_pixmap = QPixmap::fromImage(recovered_image_toshow);
-        // 计算复原图像的MSE和PSNR
-        recoveredMSE = computeMSE(gray_image, xnm_recovered);
-        recoveredPSNR = computePSNR(gray_image, xnm_recovered);
-
-        // 先对频域图进行低通滤波，再进行IFFT，得到复原图像
-        cv::Mat Xkv_filtered = cv::Mat_<std::complex<double>>(Xkv.size[0], Xkv.size[1]);
-        Xkv_filtered.setTo(0);
-        // 生成二维高斯低通滤波器，其sigma由界面上的滑动条/数值框指定
-        cv::Mat filter = createGaussianLPF(cv::Size(Xkv.size[0], Xkv.size[1]), ui->sigma_value->value());
-        // 将频域图与滤波器逐项相乘，得到滤波后的频域图
-        for(int i=0; i<Xkv.size[0]; i++)
-        for(int j=0; j<Xkv.size[1]; j++)
-        {
-            Xkv_filtered.at<std::complex<double>>(i, j) = Xkv.at<std::complex<double>>(i, j) * filter.at<std::complex<double>>(i, j);
-        }
-        // 对滤波后的频域图进行IFFT，得到复原图像
-        cv::Mat xnm_filtered_recovered = IFFT2D(Xkv_filtered, gray_image.size[0], gray_image.size[1], "uchar");
-        QImage lpf_recovered_image_toshow(xnm_filtered_recovered.data, xnm_filtered_recovered.cols, xnm_filtered_recovered.rows, xnm_filtered_recovered.step, QImage::Format_Grayscale8);
-        lpf_recovered_image_pixmap = QPixmap::fromImage(lpf_recovered_image_toshow);
-        // 计算滤波后的MSE和PSNR
-        lpfMSE = computeMSE(gray_image, xnm_filtered_recovered);
-        lpfPSNR = computePSNR(gray_image, xnm_filtered_recovered);
-
         // 针对是否滤波在界面上做出不同的显示内容
-        if(ui->without_lpf->isChecked()) 
-        {
-            ui->recovered_image->setPixmap(recovered_image_pixmap);
-            ui->vs_prompt->setText("Recovered Image VS Original Image:");
-            ui->mse_value->setText(QString::number(recoveredMSE));
-            ui->psnr_value->setText(QString::number(recoveredPSNR)+"dB");
-        }
-        else if(ui->with_lpf->isChecked())
-        {
-            ui->recovered_image->setPixmap(lpf_recovered_image_pixmap);
-            ui->vs_prompt->setText("Filtered Image VS Original Image:");
-            ui->mse_value->setText(QString::number(lpfMSE));
-            ui->psnr_value->setText(QString::number(lpfPSNR)+"dB");
-        }
+        showRecovered();
     }
     else
     {
@@ -131,6 +99,28 @@ void Widget::on_enter_ok_clicked()
 }
 
 
+/**
+ * @brief 根据是否滤波的选项显示对应的重建图像及其MSE和PSNR，没有缓存时才进行滤波、IFFT和误差计算
+ */
+void Widget::showRecovered()
+{
+    const bool filtered = ui->with_lpf->isChecked();
+    const cv::Mat& xnm_recovered = graph.recovered(filtered);
+    if(!xnm_recovered.empty())
+    {
+        QImage recovered_image_toshow(xnm_recovered.data, xnm_recovered.cols, xnm_recovered.rows, xnm_recovered.step, QImage::Format_Grayscale8);
+        ui->recovered_image->setPixmap(QPixmap::fromImage(recovered_image_toshow));
+    }
+    else
+    {
+        ui->recovered_image->setText("no image");
+    }
+    ui->vs_prompt->setText(filtered ? "Filtered Image VS Original Image:" : "Recovered Image VS Original Image:");
+    ui->mse_value->setText(QString::number(graph.mse(filtered)));
+    ui->psnr_value->setText(QString::number(graph.psnr(filtered))+"dB");
+}
+
+
 /**
  * @brief 当是否进行低通滤波的选项发生变化时，根据选项的状态显示不同的内容
  * @param state 
@@ -139,95 +129,110 @@ void Widget::on_without_lpf_stateChanged(bool state)
 {
     if(state) // 选中了“不进行低通滤波”选项
     {
-        if(!recovered_image_pixmap.isNull())
-        {
-            ui->recovered_image->setPixmap(recovered_image_pixmap);
-        }
-        else
-        {
-            ui->recovered_image->setText("no image");
-        }
         ui->sigma_prompt->hide();
         ui->sigma_slider->hide();
         ui->sigma_value->hide();
-        ui->vs_prompt->setText("Recovered Image VS Original Image:");
-        ui->mse_value->setText(QString::number(recoveredMSE));
-        ui->psnr_value->setText(QString::number(recoveredPSNR)+"dB");
     }
     else // 选中了“进行低通滤波”选项
     {
-        if(!lpf_recovered_image_pixmap.isNull())
-        {
-            ui->recovered_image->setPixmap(lpf_recovered_image_pixmap);
-        }
-        else
-        {
-            ui->recovered_image->setText("no image");
-        }
         ui->sigma_prompt->show();
         ui->sigma_slider->show();
         ui->sigma_value->show();
-        ui->vs_prompt->setText("Filtered Image VS Original Image:");
-        ui->mse_value->setText(QString::number(lpfMSE));
-        ui->psnr_value->setText(QString::number(lpfPSNR)+"dB");
     }
+    showRecovered();
 }
 
 
 /**
- * @brief 当二维高斯低通滤波器的sigma参数因为滑动条发生变化时，根据新的sigma值重新生成滤波器并进行滤波和图像重建
+ * @brief 当是否显示相位谱的选项发生变化时，切换频谱图显示的内容，频谱本身不会重新计算
+ * @param state 
+ */
+void Widget::on_show_phase_stateChanged(bool state)
+{
+    graph.setShowPhase(state);
+    ui->fft_result_prompt->setText(state ? "FFT Result(Grayscale Phase Spectrum)" : "FFT Result(Grayscale Amplitude Spectrum)");
+
+    const cv::Mat& Xkv_8u = graph.spectrumImage();
+    if(!Xkv_8u.empty())
+    {
+        QImage Xkv_8u_toshow(Xkv_8u.data, Xkv_8u.cols, Xkv_8u.rows, Xkv_8u.step, QImage::Format_Grayscale8);
+        ui->fft_image->setPixmap(QPixmap::fromImage(Xkv_8u_toshow));
+    }
+}
+
+
+/**
+ * @brief 当二维高斯低通滤波器的sigma参数因为滑动条发生变化时，同步数值框，由数值框的槽函数完成滤波和图像重建
  * @param value 
  */
 void Widget::on_with_sigma_slider_valueChanged(int value)
 {
     ui->sigma_value->setValue(value);
-    cv::Mat Xkv_filtered = cv::Mat_<std::complex<double>>(Xkv.size[0], Xkv.size[1]);
-    Xkv_filtered.setTo(0);
-    cv::Mat filter = createGaussianLPF(cv::Size(Xkv.size[0], Xkv.size[1]), ui->sigma_value->value());
+}
 
-    for(int i=0; i<Xkv.size[0]; i++)
-    for(int j=0; j<Xkv.size[1]; j++)
-    {
-        Xkv_filtered.at<std::complex<double>>(i, j) = Xkv.at<std::complex<double>>(i, j) * filter.at<std::complex<double>>(i, j);
-    }
-    cv::Mat xnm_filtered_recovered = IFFT2D(Xkv_filtered, gray_image.size[0], gray_image.size[1], "uchar");
-    QImage lpf_recovered_image_toshow(xnm_filtered_recovered.data, xnm_filtered_recovered.cols, xnm_filtered_recovered.rows, xnm_filtered_recovered.step, QImage::Format_Grayscale8);
-    lpf_recovered_image_pixmap = QPixmap::fromImage(lpf_recovered_image_toshow);
 
+/**
+ * @brief 当二维高斯低通滤波器的sigma参数因为数值框发生变化时，使滤波器及其下游的结果失效，
+ *        如果当前显示的是滤波重建图像，则重新滤波并进行图像重建
+ * @param value 
+ */
+void Widget::on_with_sigma_value_valueChanged(int value)
+{
+    ui->sigma_slider->setValue(value);
+    graph.setSigma(value);
     if(ui->with_lpf->isChecked())
     {
-        ui->recovered_image->setPixmap(lpf_recovered_image_pixmap);
+        showRecovered();
     }
 }
 
 
 /**
- * @brief 当二维高斯低通滤波器的sigma参数因为数值框发生变化时，根据新的sigma值重新生成滤波器并进行滤波和图像重建
- * @param value 
+ * @brief Find按钮的槽函数，在当前频谱上搜索使PSNR达到目标值的最小sigma，并将其设置到滑动条/数值框上
  */
-void Widget::on_with_sigma_value_valueChanged(int value)
+void Widget::on_find_sigma_clicked()
 {
-    ui->sigma_slider->setValue(value);
-    cv::Mat Xkv_filtered = cv::Mat_<std::complex<double>>(Xkv.size[0], Xkv.size[1]);
-    Xkv_filtered.setTo(0);
-    cv::Mat filter = createGaussianLPF(cv::Size(Xkv.size[0], Xkv.size[1]), ui->sigma_value->value());
+    const cv::Mat& Xkv = graph.spectrum();
+    const cv::Mat& gray_image = graph.gray();
+    if(Xkv.empty() || gray_image.empty()) return;
 
-    for(int i=0; i<Xkv.size[0]; i++)
-    for(int j=0; j<Xkv.size[1]; j++)
+    double high = std::min(ui->sigma_value->maximum(), Xkv.size[0]);
+    double sigma = findMinimalBandwidth(Xkv, gray_image, ui->target_psnr->value(), 1, high, "gaussian");
+    if(sigma < 0)
     {
-        Xkv_filtered.at<std::complex<double>>(i, j) = Xkv.at<std::complex<double>>(i, j) * filter.at<std::complex<double>>(i, j);
+        QMessageBox::information(this, "Find Sigma", "Target PSNR can not be reached with sigma <= " + QString::number(high));
+        return;
     }
-    cv::Mat xnm_filtered_recovered = IFFT2D(Xkv_filtered, gray_image.size[0], gray_image.size[1], "uchar");
-    QImage lpf_recovered_image_toshow(xnm_filtered_recovered.data, xnm_filtered_recovered.cols, xnm_filtered_recovered.rows, xnm_filtered_recovered.step, QImage::Format_Grayscale8);
-    lpf_recovered_image_pixmap = QPixmap::fromImage(lpf_recovered_image_toshow);
 
-    if(ui->with_lpf->isChecked())
+    // 先设置sigma再切换到滤波选项，切换时只按新的sigma重建一次
+    ui->sigma_value->setValue(static_cast<int>(std::ceil(sigma)));
+    ui->with_lpf->setChecked(true);
+}
+
+
+/**
+ * @brief Sweep按钮的槽函数，对一组sigma批量计算滤波重建后的MSE和PSNR，并以表格形式显示
+ */
+void Widget::on_sweep_sigma_clicked()
+{
+    const cv::Mat& Xkv = graph.spectrum();
+    const cv::Mat& gray_image = graph.gray();
+    if(Xkv.empty() || gray_image.empty()) return;
+
+    // sigma从1扫描到频谱边长的一半，最多取32个点
+    int high = std::max(1, Xkv.size[0] / 2);
+    int step = std::max(1, high / 32);
+    std::vector<double> sigmas;
+    for(int sigma=1; sigma<=high; sigma+=step)
     {
-        ui->recovered_image->setPixmap(lpf_recovered_image_pixmap);
+        sigmas.push_back(sigma);
     }
+    std::vector<SweepPoint> curve = sweepLPF(Xkv, gray_image, sigmas, "gaussian");
 
-    lpfMSE = computeMSE(gray_image, xnm_filtered_recovered);
-    lpfPSNR = computePSNR(gray_image, xnm_filtered_recovered);
-    ui->mse_value->setText(QString::number(lpfMSE));
-    ui->psnr_value->setText(QString::number(lpfPSNR)+"dB");
-}
\ No newline at end of file
+    QString table = "Sigma\tMSE\tPSNR\n";
+    for(const SweepPoint& point : curve)
+    {
+        table += QString::number(point.parameter) + "\t" + QString::number(point.mse) + "\t" + QString::number(point.psnr) + "dB\n";
+    }
+    QMessageBox::information(this, "Sigma Sweep", table);
+}